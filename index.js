@@ -58,9 +58,11 @@ class RapidPointer {
 nativeModule.RapidPointer = RapidPointer
 nativeModule.makeRapidPointer = (items) => new RapidPointer(items);
 
+// options.numbers: "pointer" (по умолчанию), "bigint-if-unsafe",
+// "all-int64-bigint" или "decimal-string"
 class RapidParser {   
-    constructor(memorySize) {
-        this.document = new nativeModule.Document(memorySize);
+    constructor(memorySize, options) {
+        this.document = new nativeModule.Document(memorySize, options);
     }
 
     parse(json, pointer) {
@@ -85,5 +87,77 @@ class RapidParser {
 
 nativeModule.RapidParser = RapidParser
 
+// размер блока которым читается источник для iterateArray
+const ITERATE_CHUNK_SIZE = 64 * 1024;
+
+function* iterateChunks(iterator, pointer, read) {
+    for (;;) {
+        let value;
+        while ((value = iterator.next(pointer)) !== undefined) {
+            yield value;
+        }
+        // done только после конца данных, хвост за массивом проверен
+        if (iterator.done()) {
+            return;
+        }
+        const chunk = read();
+        if (chunk) {
+            iterator.push(chunk);
+        } else {
+            iterator.end();
+        }
+    }
+}
+
+async function* iterateStream(iterator, pointer, stream) {
+    let value;
+    for await (const chunk of stream) {
+        iterator.push(typeof chunk === "string" ? Buffer.from(chunk) : chunk);
+        while ((value = iterator.next(pointer)) !== undefined) {
+            yield value;
+        }
+    }
+    // поток читается до конца, хвост за массивом проверяет end
+    iterator.end();
+    while ((value = iterator.next(pointer)) !== undefined) {
+        yield value;
+    }
+}
+
+// элементы массива верхнего уровня по одному
+// Buffer и файловый дескриптор дают синхронный итератор, поток асинхронный
+nativeModule.iterateArray = (source, pointer, options = {}) => {
+    const iterator = new nativeModule.ArrayIterator(options.memorySize, options);
+    if (pointer && !(pointer instanceof RapidPointer)) {
+        throw new Error("pointer must be a RapidPointer");
+    }
+    if (typeof source === "string") {
+        source = Buffer.from(source);
+    }
+    if (Buffer.isBuffer(source)) {
+        let offset = 0;
+        return iterateChunks(iterator, pointer, () => {
+            if (offset >= source.length) {
+                return null;
+            }
+            const chunk = source.subarray(offset, offset + ITERATE_CHUNK_SIZE);
+            offset += chunk.length;
+            return chunk;
+        });
+    }
+    if (typeof source === "number") {
+        const fs = require("fs");
+        return iterateChunks(iterator, pointer, () => {
+            const chunk = Buffer.allocUnsafe(ITERATE_CHUNK_SIZE);
+            const size = fs.readSync(source, chunk, 0, chunk.length, null);
+            return size ? chunk.subarray(0, size) : null;
+        });
+    }
+    if (source && typeof source[Symbol.asyncIterator] === "function") {
+        return iterateStream(iterator, pointer, source);
+    }
+    throw new Error("source must be a Buffer, a file descriptor or a readable stream");
+};
+
 // Экспортируем объединенный модуль
 module.exports = nativeModule;
@@ -0,0 +1,215 @@
+#include "rapid_array_iterator.hpp"
+#include "rapid_convert.hpp"
+#include "rapidjson/error/en.h"
+#include <string>
+
+namespace rapid {
+
+Napi::FunctionReference ArrayIterator::ctor{};
+
+static bool isSpace(char c) noexcept
+{
+    return (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t');
+}
+
+ArrayIterator::ArrayIterator(const Napi::CallbackInfo& i)
+    : ObjectWrap{i}
+{
+    auto env = i.Env();
+    try {
+        self_.create(getSizeDefault(i), getNumberPolicy(i));
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+}
+
+Napi::Value ArrayIterator::error(Napi::Env env, 
+    const char* message, std::size_t offset)
+{
+    state_ = State::done;
+    Napi::Error::New(env, std::string{message} + " offset:" + 
+        std::to_string(offset)).ThrowAsJavaScriptException();
+    return env.Undefined();
+}
+
+Napi::Value ArrayIterator::tail(Napi::Env env)
+{
+    auto size = window_.size();
+    while ((pos_ < size) && isSpace(window_[pos_]))
+        ++pos_;
+
+    if (pos_ < size)
+    {
+        return error(env, "The document root must not be followed by other values.", 
+            base_ + pos_);
+    }
+
+    if (final_)
+        state_ = State::done;
+    return env.Undefined();
+}
+
+Napi::Value ArrayIterator::push(const Napi::CallbackInfo& i)
+{
+    auto env = i.Env();
+    if ((i.Length() < 1) || !i[0].IsBuffer())
+    {
+        Napi::TypeError::New(env, "argument must be a buffer")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    try {
+        // сдвигаем окно, разобранные данные больше не нужны
+        if (pos_)
+        {
+            window_.erase(window_.begin(), window_.begin() + pos_);
+            base_ += pos_;
+            wait_ = (wait_ > pos_) ? wait_ - pos_ : 0;
+            pos_ = 0;
+        }
+        auto buffer = i[0].As<Napi::Buffer<char>>();
+        window_.insert(window_.end(), buffer.Data(), buffer.Data() + buffer.Length());
+        // хвост проверяем сразу, он не должен копиться в окне
+        if (state_ == State::tail)
+            return tail(env);
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+
+    return env.Undefined();
+}
+
+Napi::Value ArrayIterator::end(const Napi::CallbackInfo& i)
+{
+    final_ = true;
+    if (state_ == State::tail)
+        return tail(i.Env());
+    return i.Env().Undefined();
+}
+
+Napi::Value ArrayIterator::done(const Napi::CallbackInfo& i)
+{
+    return Napi::Boolean::New(i.Env(), state_ == State::done);
+}
+
+Napi::Value ArrayIterator::next(const Napi::CallbackInfo& i)
+{
+    auto env = i.Env();
+    auto size = window_.size();
+    while (state_ != State::done)
+    {
+        if (state_ == State::tail)
+            return tail(env);
+
+        // пропускаем пробелы между элементами
+        while ((pos_ < size) && isSpace(window_[pos_]))
+            ++pos_;
+
+        if (pos_ == size)
+        {
+            // данных больше не будет, а массив не закрыт
+            if (final_)
+                return error(env, "Unexpected end of array.", base_ + pos_);
+            // ждем следующий блок
+            return env.Undefined();
+        }
+
+        auto c = window_[pos_];
+        switch (state_) {
+            case State::begin:
+                if (c != '[')
+                    return error(env, "The document root must be an array.", base_ + pos_);
+                ++pos_;
+                state_ = State::first;
+                continue;
+            case State::first:
+                if (c == ']')
+                {
+                    ++pos_;
+                    state_ = State::tail;
+                    continue;
+                }
+                state_ = State::element;
+                continue;
+            case State::next:
+                if (c == ']') {
+                    ++pos_;
+                    state_ = State::tail;
+                } else if (c == ',') {
+                    ++pos_;
+                    state_ = State::element;
+                } else {
+                    return error(env, "Missing a comma or ']' after an array element.", base_ + pos_);
+                }
+                continue;
+            default: ;
+        }
+
+        // неполный элемент не разбираем пока окно не вырастет вдвое
+        // иначе большой элемент из мелких блоков разбирается квадратично
+        if (!final_ && (size < wait_))
+            return env.Undefined();
+
+        // элемент разбирается как отдельный документ
+        // пул документа очищается перед каждым элементом
+        constexpr auto flags = rapidjson::kParseIterativeFlag | 
+            rapidjson::kParseStopWhenDoneFlag;
+        WindowStream stream{window_.data() + pos_, window_.data() + size};
+        auto result = self_.parseStream<flags>(stream);
+        if (stream.starved() && !final_)
+        {
+            wait_ = size + (size - pos_);
+            return env.Undefined();
+        }
+
+        if (!result)
+        {
+            return error(env, rapidjson::GetParseError_En(self_.parseError()), 
+                base_ + pos_ + self_.parseOffset());
+        }
+
+        pos_ += stream.Tell();
+        wait_ = 0;
+        state_ = State::next;
+
+        auto pointer = Napi::Array::New(env, 0);
+        if (i.Length() > 0)
+        {
+            auto& arg0 = i[0];
+            // arg0 это RapidPointer со свойством pointer типа Array
+            if (arg0.IsObject())
+            {
+                auto obj = arg0.As<Napi::Object>();
+                pointer = obj.Get("pointer").As<Napi::Array>();
+            }
+        }
+
+        // элемент находится по пути #/*
+        constexpr fnv1a hf;
+        constexpr auto root = hf("#");
+        constexpr auto slash = fnv1a{root}("/");
+        constexpr auto hash = fnv1a{slash}("*");
+        RawCursor raw{&self_.raw()};
+        RapidConvert<rapidjson::Value> f{env, pointer, 1, hash, self_.policy(), &raw};
+        return f(self_.get());
+    }
+
+    return env.Undefined();
+}
+
+void ArrayIterator::Init(Napi::Env env, Napi::Object exports)
+{
+    auto className = "ArrayIterator";
+    auto func = DefineClass(env, className, {
+        InstanceMethod("push", &ArrayIterator::push),
+        InstanceMethod("end", &ArrayIterator::end),
+        InstanceMethod("next", &ArrayIterator::next),
+        InstanceMethod("done", &ArrayIterator::done)
+    });
+    ctor = Napi::Persistent(func);
+    ctor.SuppressDestruct();
+    exports.Set(className, func);
+}
+
+} // namespace rapid
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "rapid_basic_document.hpp"
+
+namespace rapid {
+
+// окно входных данных для rapidjson::Reader
+// Peek за концом окна возвращает 0 и запоминает нехватку данных
+class WindowStream final
+{
+    const char* begin_{};
+    const char* p_{};
+    const char* end_{};
+    mutable bool starved_{};
+
+public:
+    typedef char Ch;
+
+    WindowStream(const char* begin, const char* end) noexcept
+        : begin_{begin}
+        , p_{begin}
+        , end_{end}
+    {   }
+
+    Ch Peek() const noexcept
+    {
+        if (p_ == end_)
+        {
+            starved_ = true;
+            return '\0';
+        }
+        return *p_;
+    }
+
+    Ch Take() noexcept
+    {
+        if (p_ == end_)
+        {
+            starved_ = true;
+            return '\0';
+        }
+        return *p_++;
+    }
+
+    std::size_t Tell() const noexcept
+    {
+        return static_cast<std::size_t>(p_ - begin_);
+    }
+
+    Ch* PutBegin() { RAPIDJSON_ASSERT(false); return 0; }
+    void Put(Ch) { RAPIDJSON_ASSERT(false); }
+    void Flush() { RAPIDJSON_ASSERT(false); }
+    std::size_t PutEnd(Ch*) { RAPIDJSON_ASSERT(false); return 0; }
+
+    bool starved() const noexcept
+    {
+        return starved_;
+    }
+};
+
+// разбор большого массива верхнего уровня по одному элементу
+// в памяти только окно с текущим элементом и его DOM
+class ArrayIterator final
+    : public Napi::ObjectWrap<ArrayIterator>
+{
+    // tail это пробелы после закрывающей скобки до конца данных
+    enum class State { begin, first, element, next, tail, done };
+
+    BasicDocument self_;
+    std::vector<char> window_;
+    // позиция разбора в окне
+    std::size_t pos_{};
+    // смещение начала окна от начала данных
+    std::size_t base_{};
+    // размер окна при котором повторим разбор неполного элемента
+    std::size_t wait_{};
+    bool final_{};
+    State state_{State::begin};
+
+    Napi::Value error(Napi::Env env, const char* message, std::size_t offset);
+
+    // после массива допустимы только пробелы
+    Napi::Value tail(Napi::Env env);
+
+public:
+    static Napi::FunctionReference ctor;
+
+    ArrayIterator(const Napi::CallbackInfo& i);
+
+    Napi::Value push(const Napi::CallbackInfo& i);
+
+    Napi::Value end(const Napi::CallbackInfo& i);
+
+    Napi::Value next(const Napi::CallbackInfo& i);
+
+    Napi::Value done(const Napi::CallbackInfo& i);
+
+    static void Init(Napi::Env env, Napi::Object exports);
+};
+
+} // namespace rapid
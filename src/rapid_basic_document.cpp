@@ -1,4 +1,8 @@
 #include "rapid_basic_document.hpp"
+#include "rapidjson/encodedstream.h"
+#include "rapidjson/memorystream.h"
+#include <stdexcept>
+#include <string>
 
 namespace rapid {
 
@@ -17,8 +21,38 @@ std::size_t getSizeDefault(const Napi::CallbackInfo& i)
     return (size < sizeDefault) ? sizeDefault : static_cast<std::size_t>(size);
 }
 
-void BasicDocument::create(std::size_t chunkSize)
+NumberPolicy getNumberPolicy(const Napi::CallbackInfo& i)
+{
+    if (i.Length() > 1)
+    {
+        auto& arg1 = i[1];
+        if (arg1.IsObject())
+        {
+            auto numbers = arg1.As<Napi::Object>().Get("numbers");
+            if (numbers.IsString())
+            {
+                auto name = numbers.As<Napi::String>().Utf8Value();
+                if (name == "pointer")
+                    return NumberPolicy::pointer;
+                if (name == "bigint-if-unsafe")
+                    return NumberPolicy::bigintIfUnsafe;
+                if (name == "all-int64-bigint")
+                    return NumberPolicy::int64Bigint;
+                if (name == "decimal-string")
+                    return NumberPolicy::decimalString;
+                throw std::invalid_argument("unknown number policy: " + name);
+            }
+
+            if (!numbers.IsUndefined())
+                throw std::invalid_argument("numbers must be a string");
+        }
+    }
+    return NumberPolicy::pointer;
+}
+
+void BasicDocument::create(std::size_t chunkSize, NumberPolicy policy)
 {   
+    policy_ = policy;
     chunk_.resize(chunkSize);
     // создаем аллокатор
     mem_.reset(new PoolAllocatorType{chunk_.data(), chunk_.size()});
@@ -28,11 +62,20 @@ void BasicDocument::create(std::size_t chunkSize)
 
 bool BasicDocument::parse(const char* json, std::size_t size)
 {
+    if (policy_ != NumberPolicy::pointer)
+    {
+        // тот же поток что и в rapidjson::Document::Parse
+        rapidjson::MemoryStream ms{json, size};
+        rapidjson::EncodedInputStream<rapidjson::UTF8<>, rapidjson::MemoryStream> is{ms};
+        return parseRaw<rapidjson::kParseDefaultFlags>(is);
+    }
+
     mem_->Clear();
     // парсим json
     self_->Parse(json, size);
+    result_ = self_->GetParseResult();
     // возвращаем результат парсинга
-    return !self_->HasParseError();
+    return !result_.IsError();
 }
 
 } // namespace rapid
\ No newline at end of file
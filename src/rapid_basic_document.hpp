@@ -1,23 +1,110 @@
 #pragma once
 
 #include "rapid_type.hpp"
+#include "rapid_raw_number.hpp"
+#include "rapidjson/reader.h"
 
 namespace rapid {
 
 std::size_t getSizeDefault(const Napi::CallbackInfo& i);
 
+// политика чисел из опций во втором аргументе { numbers: "..." }
+NumberPolicy getNumberPolicy(const Napi::CallbackInfo& i);
+
 class BasicDocument final
 {
     std::vector<char> chunk_;
     DocumentAllocator mem_;
     DocumentPtr self_;
+    NumberPolicy policy_{NumberPolicy::pointer};
+    // текст чисел которые в DOM стали double
+    RawNumbers raw_;
+    // результат последнего разбора, в том числе через RawNumberHandler
+    rapidjson::ParseResult result_;
+
+    // разбор с решением по тексту каждого числа
+    template<unsigned flags, class S>
+    bool parseRaw(S& stream)
+    {
+        auto g = [&](auto& handler) {
+            RawNumberHandler<std::decay_t<decltype(handler)>> h{handler, raw_, 
+                policy_ == NumberPolicy::decimalString};
+            rapidjson::Reader reader;
+            result_ = reader.Parse<flags | rapidjson::kParseNumbersAsStringsFlag>(stream, h);
+            // ошибка как у разбора без обработчика, rapidjson тоже
+            // указывает на начало числа
+            if (h.numberTooBig() && 
+                (result_.Code() == rapidjson::kParseErrorTermination))
+                result_.Set(rapidjson::kParseErrorNumberTooBig, result_.Offset());
+            return !result_.IsError();
+        };
+        return populate(g);
+    }
+
 public:
     BasicDocument() = default;
 
-    void create(std::size_t chunkSize);
+    void create(std::size_t chunkSize, 
+        NumberPolicy policy = NumberPolicy::pointer);
+
+    NumberPolicy policy() const noexcept
+    {
+        return policy_;
+    }
+
+    const RawNumbers& raw() const noexcept
+    {
+        return raw_;
+    }
+
+    bool hasParseError() const noexcept
+    {
+        return result_.IsError();
+    }
+
+    rapidjson::ParseErrorCode parseError() const noexcept
+    {
+        return result_.Code();
+    }
+
+    std::size_t parseOffset() const noexcept
+    {
+        return result_.Offset();
+    }
 
     bool parse(const char* json, std::size_t size);
 
+    // разбор одного значения из потока
+    template<unsigned flags, class S>
+    bool parseStream(S& stream)
+    {
+        // без RapidPointer числа разбираются по тексту
+        if (policy_ != NumberPolicy::pointer)
+            return parseRaw<flags>(stream);
+
+        mem_->Clear();
+        self_->ParseStream<flags>(stream);
+        result_ = self_->GetParseResult();
+        return !result_.IsError();
+    }
+
+    // строит документ из событий SAX генератора
+    template<class G>
+    bool populate(G& generator)
+    {
+        mem_->Clear();
+        raw_.clear();
+        result_.Clear();
+        auto result = false;
+        auto g = [&](auto& handler) {
+            return result = generator(handler);
+        };
+        self_->Populate(g);
+        if (!result)
+            self_->SetNull();
+        return result;
+    }
+
     bool accept(rapidjson::SchemaValidator& v) const
     {
         return self_->Accept(v);
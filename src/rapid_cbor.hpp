@@ -0,0 +1,106 @@
+#pragma once
+
+#include "rapid_type.hpp"
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace rapid {
+
+// кодирует rapidjson::Value в cbor (RFC 8949)
+// uint64 и int64 сохраняются как есть, без потери точности
+class CborWriter final
+{
+    std::vector<char>& out_;
+
+    void put(std::uint8_t c)
+    {
+        out_.push_back(static_cast<char>(c));
+    }
+
+    // big-endian
+    template<class T>
+    void put(std::uint8_t tag, T val)
+    {
+        static_assert(std::is_unsigned_v<T>);
+        put(tag);
+        for (auto i = sizeof(T); i--; )
+            put(static_cast<std::uint8_t>(val >> (i * 8)));
+    }
+
+    // заголовок: старший тип и аргумент минимальной длины
+    void head(std::uint8_t major, std::uint64_t val)
+    {
+        major <<= 5;
+        if (val < 24) {
+            put(static_cast<std::uint8_t>(major | val));
+        } else if (val <= std::numeric_limits<std::uint8_t>::max()) {
+            put(major | 24, static_cast<std::uint8_t>(val));
+        } else if (val <= std::numeric_limits<std::uint16_t>::max()) {
+            put(major | 25, static_cast<std::uint16_t>(val));
+        } else if (val <= std::numeric_limits<std::uint32_t>::max()) {
+            put(major | 26, static_cast<std::uint32_t>(val));
+        } else {
+            put(major | 27, val);
+        }
+    }
+
+    void string(const char* str, std::uint32_t length)
+    {
+        head(3, length);
+        out_.insert(out_.end(), str, str + length);
+    }
+
+public:
+    explicit CborWriter(std::vector<char>& out) noexcept
+        : out_{out}
+    {   }
+
+    void operator()(const rapidjson::Value& value)
+    {
+        switch (value.GetType()) {
+            case rapidjson::kNullType:
+                put(0xf6);
+                break;
+            case rapidjson::kFalseType:
+                put(0xf4);
+                break;
+            case rapidjson::kTrueType:
+                put(0xf5);
+                break;
+            case rapidjson::kObjectType:
+                head(5, value.MemberCount());
+                for (auto& m : value.GetObject())
+                {
+                    string(m.name.GetString(), m.name.GetStringLength());
+                    (*this)(m.value);
+                }
+                break;
+            case rapidjson::kArrayType:
+                head(4, value.Size());
+                for (auto& v : value.GetArray())
+                    (*this)(v);
+                break;
+            case rapidjson::kStringType:
+                string(value.GetString(), value.GetStringLength());
+                break;
+            case rapidjson::kNumberType:
+                if (value.IsUint64()) {
+                    head(0, value.GetUint64());
+                } else if (value.IsInt64()) {
+                    // отрицательное n кодируется как -1 - n
+                    head(1, ~static_cast<std::uint64_t>(value.GetInt64()));
+                } else {
+                    auto d = value.GetDouble();
+                    std::uint64_t bits;
+                    std::memcpy(&bits, &d, sizeof(d));
+                    put(0xfb, bits);
+                }
+                break;
+            default: ;
+        }
+    }
+};
+
+} // namespace rapid
@@ -2,7 +2,7 @@
 
 #include "rapid_type.hpp"
 #include "rapid_fnv1a.hpp"
-#include "rapid_convert.hpp"
+#include "rapid_raw_number.hpp"
 #include <ranges>
 #include <charconv>
 
@@ -24,7 +24,9 @@ auto copyout(const Napi::Value& value, A& alloc) {
 struct RapidNumber final 
 {
     Napi::Env& env;
-    Napi::Value operator()(const rapidjson::Value& elem)
+
+    template<class V>
+    Napi::Value operator()(const V& elem)
     {
         if (elem.IsUint64()) {
             auto val = elem.GetUint64();
@@ -44,12 +46,16 @@ struct RapidNumber final
     }
 };
 
+template<class V>
 struct RapidConvert final 
 {
     Napi::Env& env;
     Napi::Array& pointer;
     std::size_t level;
     fnv1a hf;
+    NumberPolicy policy{NumberPolicy::pointer};
+    // исходный текст double, есть только у разобранного документа
+    RawCursor* raw{};
 
     bool match() const
     {
@@ -76,8 +82,54 @@ struct RapidConvert final
         return false;
     }
 
-    Napi::Value number(const rapidjson::Value& value) const
+    // целое вне 64 бит по его исходному тексту
+    Napi::Value bigint(std::string_view text) const
+    {
+        auto words = integerWords(text);
+        auto sign = (!text.empty() && (text.front() == '-')) ? 1 : 0;
+        return Napi::BigInt::New(env, sign, words.size(), words.data());
+    }
+
+    // решение по самому числу, без поиска пути
+    Napi::Value lossless(const V& value) const
+    {
+        if (value.IsUint64() || value.IsInt64())
+        {
+            if (policy == NumberPolicy::int64Bigint)
+            {
+                RapidNumber f{env};
+                return f(value);
+            }
+
+            if (value.IsUint64()) {
+                auto val = value.GetUint64();
+                if (val > number_max_safe)
+                    return Napi::BigInt::New(env, val);
+            } else {
+                auto val = value.GetInt64();
+                if (val < -static_cast<std::int64_t>(number_max_safe))
+                    return Napi::BigInt::New(env, val);
+            }
+            return Napi::Number::New(env, value.GetDouble());
+        }
+
+        // double идут в DOM в порядке разбора, как и их текст
+        auto text = raw ? raw->take() : std::string_view{};
+        if (!text.empty())
+        {
+            if (isIntegerText(text))
+                return bigint(text);
+            if (policy == NumberPolicy::decimalString)
+                return Napi::String::New(env, text.data(), text.size());
+        }
+        return Napi::Number::New(env, value.GetDouble());
+    }
+
+    Napi::Value number(const V& value) const
     {
+        if (policy != NumberPolicy::pointer)
+            return lossless(value);
+
         if (match())
         {
             RapidNumber f{env};
@@ -86,11 +138,11 @@ struct RapidConvert final
         return Napi::Number::New(env, value.GetDouble());
     }
 
-    Napi::Value str(const rapidjson::Value& value) const
+    Napi::Value str(const V& value) const
     {
         auto p = value.GetString();
         auto length = value.GetStringLength();
-        if (match())
+        if ((policy == NumberPolicy::pointer) && match())
         {
             auto end = p + length;
             if (length > 1) {
@@ -111,55 +163,67 @@ struct RapidConvert final
         return Napi::String::New(env, p, length);
     }
 
-    Napi::Value operator()(const rapidjson::Value& value) const;
+    Napi::Value operator()(const V& value) const;
 };
 
+template<class V>
 struct RapidObject final 
 {
     Napi::Env& env;
     Napi::Array& pointer;
     std::size_t level;
     fnv1a hf;
+    NumberPolicy policy;
+    RawCursor* raw;
 
-    Napi::Value operator()(const rapidjson::Value& elem) 
+    Napi::Value operator()(const V& elem) 
     {
         auto res = Napi::Object::New(env);
+        auto hashing = (policy == NumberPolicy::pointer);
         for (auto&& [key, val] : elem.GetObject()) 
         {
             auto s = key.GetString();
             //std::cout << "RapidObject " << std::string_view{s, key.GetStringLength()} << "=" << hf(s, key.GetStringLength()) << std::endl;
-            RapidConvert f{env, pointer, level + 1, hf(s, key.GetStringLength())};
-            res.Set(s, f(val));
+            // без RapidPointer путь не нужен
+            auto hash = hashing ? hf(s, key.GetStringLength()) : std::uint32_t{};
+            RapidConvert<V> f{env, pointer, level + 1, hash, policy, raw};
+            // длина ключа известна, strlen не нужен
+            res.Set(Napi::String::New(env, s, key.GetStringLength()), f(val));
         }
         return res;
     }
 };
 
+template<class V>
 struct RapidArray final 
 {
     Napi::Env& env;
     Napi::Array& pointer;
     std::size_t level;
     fnv1a hf;
-    Napi::Value operator()(const rapidjson::Value& elem) const
+    NumberPolicy policy;
+    RawCursor* raw;
+
+    Napi::Value operator()(const V& elem) const
     {
         using namespace std::string_view_literals;
         auto size = elem.Size();
         //std::cout << "RapidArray " << size << std::endl;
         auto res = Napi::Array::New(env, size);
         auto hashval = hf("*");
-        for (auto i = 0u; i < size; ++i) 
+        auto i = 0u;
+        for (auto&& val : elem.GetArray()) 
         {
-            auto& val = elem[i];
             //std::cout << "RapidArray " << i << std::endl;
-            RapidConvert f{env, pointer, level + 1, hashval};
-            res.Set(i, f(val));
+            RapidConvert<V> f{env, pointer, level + 1, hashval, policy, raw};
+            res.Set(i++, f(val));
         }
         return res;        
     }
 };
 
-Napi::Value RapidConvert::operator()(const rapidjson::Value& value) const
+template<class V>
+Napi::Value RapidConvert<V>::operator()(const V& value) const
 {
     switch (value.GetType()) {
         case rapidjson::kNullType:
@@ -170,12 +234,12 @@ Napi::Value RapidConvert::operator()(const rapidjson::Value& value) const
             return Napi::Boolean::New(env, true);
         case rapidjson::kObjectType: {
             //std::cout << "/{} " << level << std::endl;
-            RapidObject f{env, pointer, level, hf("/")};
+            RapidObject<V> f{env, pointer, level, hf("/"), policy, raw};
             return f(value);
         };
         case rapidjson::kArrayType: {
             //std::cout << "/[] " << level << std::endl;
-            RapidArray f{env, pointer, level, hf("/")};
+            RapidArray<V> f{env, pointer, level, hf("/"), policy, raw};
             return f(value);
         };
         case rapidjson::kStringType: {
@@ -190,11 +254,13 @@ Napi::Value RapidConvert::operator()(const rapidjson::Value& value) const
     return env.Undefined();
 }
 
-auto convert(Napi::Env& env, Napi::Array& pointer, std::size_t level = 0) {
+template<class V = rapidjson::Value>
+auto convert(Napi::Env& env, Napi::Array& pointer, std::size_t level = 0, 
+    NumberPolicy policy = NumberPolicy::pointer, RawCursor* raw = nullptr) {
     constexpr fnv1a hf;
     constexpr auto hash = hf("#");
     //std::cout << "# " << level << std::endl;
-    return RapidConvert{env, pointer, level, hash};
+    return RapidConvert<V>{env, pointer, level, hash, policy, raw};
 }
 
 } // namespace rapid
\ No newline at end of file
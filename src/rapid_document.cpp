@@ -1,10 +1,16 @@
 #include "rapid_document.hpp"
 #include "rapid_convert.hpp"
 #include "rapid_fnv1a.hpp"
+#include "rapid_tape_view.hpp"
+#include "rapid_msgpack.hpp"
+#include "rapid_cbor.hpp"
+#include "rapid_mapped_file.hpp"
 #include "rapidjson/error/en.h"
 #include <limits>
+#include <memory>
 #include <cmath>
 #include <ranges>
+#include <string>
 #include <napi.h>
 //#include <iostream>
 
@@ -14,43 +20,77 @@ namespace rapid {
 
 Napi::FunctionReference Document::ctor{};
 
+// Buffer владеет закодированными данными, копии нет
+// память освобождается вместе с Buffer
+static Napi::Value moveToBuffer(Napi::Env env, std::vector<char>&& out)
+{
+    auto data = std::make_unique<std::vector<char>>(std::move(out));
+    auto buffer = Napi::Buffer<char>::New(env, data->data(), data->size(),
+        [](Napi::Env, char*, std::vector<char>* hint) {
+            delete hint;
+        }, data.get());
+    // теперь вектор удалит финализатор
+    data.release();
+    return buffer;
+}
+
 Document::Document(const Napi::CallbackInfo& i)
     : ObjectWrap{i}
 {   
     auto env = i.Env();
     try {
-        self_.create(getSizeDefault(i));
+        self_.create(getSizeDefault(i), getNumberPolicy(i));
     } catch (const std::exception& e) {
         Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
     }
 }
 
+bool Document::checkBusy(Napi::Env env) const
+{
+    if (busy_)
+    {
+        Napi::Error::New(env, "document is busy")
+            .ThrowAsJavaScriptException();
+    }
+    return busy_;
+}
+
 Napi::Value Document::hasParseError(const Napi::CallbackInfo& i)
 {
-    auto& d = self_.get();
-    return Napi::Boolean::New(i.Env(), d.HasParseError());
+    auto env = i.Env();
+    if (checkBusy(env))
+        return env.Undefined();
+
+    return Napi::Boolean::New(env, self_.hasParseError());
 }
 
 Napi::Value Document::parseError(const Napi::CallbackInfo& i)
 {          
     auto env = i.Env();
-    auto& d = self_.get();
-    return Napi::Number::New(env, d.GetParseError());
+    if (checkBusy(env))
+        return env.Undefined();
+
+    return Napi::Number::New(env, self_.parseError());
 }
 
 Napi::Value Document::parseOffset(const Napi::CallbackInfo& i)
 {
     auto env = i.Env();
-    auto& d = self_.get();
-    return Napi::Number::New(env, d.GetErrorOffset());    
+    if (checkBusy(env))
+        return env.Undefined();
+
+    return Napi::Number::New(env, 
+        static_cast<double>(self_.parseOffset()));
 }
 
 Napi::Value Document::parseMessage(const Napi::CallbackInfo& i)
 {
     auto env = i.Env();
-    auto& d = self_.get();
+    if (checkBusy(env))
+        return env.Undefined();
+
     return Napi::String::New(env, 
-        rapidjson::GetParseError_En(d.GetParseError()));
+        rapidjson::GetParseError_En(self_.parseError()));
 }
 
 Napi::Value Document::parse(const Napi::CallbackInfo& i)
@@ -68,6 +108,9 @@ Napi::Value Document::parse(const Napi::CallbackInfo& i)
         arg0.IsNumber() || arg0.IsBoolean())
         return arg0;
 
+    if (checkBusy(env))
+        return env.Undefined();
+
     // аргумент должен быть строкой или буффером
     if (!arg0.IsBuffer())
     {
@@ -90,9 +133,110 @@ Napi::Value Document::parse(const Napi::CallbackInfo& i)
     return Napi::Boolean::New(env, false);
 }
 
+// разбор файла вне event loop
+// документ удерживается от сборки мусора до завершения
+class ParseFileWorker final
+    : public Napi::AsyncWorker
+{
+    Document& doc_;
+    std::string path_;
+    Napi::Promise::Deferred deferred_;
+    bool result_{};
+
+public:
+    ParseFileWorker(Napi::Env env, Document& doc, std::string path)
+        : AsyncWorker{env}
+        , doc_{doc}
+        , path_{std::move(path)}
+        , deferred_{Napi::Promise::Deferred::New(env)}
+    {
+        doc_.Ref();
+        doc_.busy_ = true;
+    }
+
+    Napi::Promise promise() const
+    {
+        return deferred_.Promise();
+    }
+
+    void Execute() override
+    {
+        try {
+            MappedFile file{path_};
+            result_ = doc_.self_.parse(file.data(), file.size());
+        } catch (const std::exception& e) {
+            SetError(e.what());
+        } catch (...) {
+            SetError("Document::parseFile");
+        }
+    }
+
+    void OnOK() override
+    {
+        done();
+        deferred_.Resolve(Napi::Boolean::New(Env(), result_));
+    }
+
+    void OnError(const Napi::Error& e) override
+    {
+        done();
+        deferred_.Reject(e.Value());
+    }
+
+private:
+    void done()
+    {
+        doc_.busy_ = false;
+        doc_.Unref();
+    }
+};
+
+Napi::Value Document::parseFile(const Napi::CallbackInfo& i)
+{
+    auto env = i.Env();
+    if ((i.Length() < 1) || !i[0].IsString())
+    {
+        Napi::TypeError::New(env, "path must be a string")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    if (checkBusy(env))
+        return env.Undefined();
+
+    auto path = i[0].As<Napi::String>().Utf8Value();
+    auto async = false;
+    if ((i.Length() > 1) && i[1].IsObject())
+        async = i[1].As<Napi::Object>().Get("async").ToBoolean().Value();
+
+    if (async)
+    {
+        auto worker = new ParseFileWorker{env, *this, std::move(path)};
+        auto promise = worker->promise();
+        worker->Queue();
+        return promise;
+    }
+
+    try {
+        // строки копируются в пул документа
+        // поэтому отображение снимается сразу после разбора
+        MappedFile file{path};
+        return Napi::Boolean::New(env, self_.parse(file.data(), file.size()));
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    } catch (...) {
+        Napi::Error::New(env, "Document::parseFile").ThrowAsJavaScriptException();
+    }
+
+    return Napi::Boolean::New(env, false);
+}
+
 Napi::Value Document::getResult(const Napi::CallbackInfo& i)
 {
     auto env = i.Env();
+    if (checkBusy(env))
+        return env.Undefined();
+
     // если нам передали массив поинтеров
     if (i.Length() == 1)
     {
@@ -117,10 +261,128 @@ Napi::Value Document::getResult(const Napi::CallbackInfo& i)
 
 Napi::Value Document::getResult(Napi::Env& env, Napi::Array& pointer, std::size_t level) const
 {
-    auto f = convert(env, pointer, level);
+    RawCursor raw{&self_.raw()};
+    auto f = convert(env, pointer, level, self_.policy(), &raw);
     return f(self_.get());
 }
 
+Napi::Value Document::tapeSize(const Napi::CallbackInfo& i)
+{
+    auto env = i.Env();
+    if (checkBusy(env))
+        return env.Undefined();
+
+    return Napi::Number::New(env, 
+        static_cast<double>(TapeWriter::size(self_.get())));
+}
+
+Napi::Value Document::toTape(const Napi::CallbackInfo& i)
+{
+    auto env = i.Env();
+    if (checkBusy(env))
+        return env.Undefined();
+
+    auto& d = self_.get();
+    // DOM обходится один раз для размера и один раз для записи
+    auto count = TapeWriter::count(d);
+    auto size = count.size();
+    TapeWriter writer;
+
+    // без аргумента создаем новый ArrayBuffer
+    if (i.Length() == 0)
+    {
+        auto buffer = Napi::ArrayBuffer::New(env, size);
+        writer(d, buffer.Data(), count);
+        return buffer;
+    }
+
+    // иначе пишем в переданный буфер, например поверх SharedArrayBuffer
+    auto bytes = tapeBytes(i[0]);
+    if (bytes.data() == nullptr)
+        return env.Undefined();
+
+    if (bytes.size() < size)
+    {
+        Napi::RangeError::New(env, "buffer is too small for the tape")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    if (reinterpret_cast<std::uintptr_t>(bytes.data()) % alignof(TapeNode))
+    {
+        Napi::RangeError::New(env, "buffer must be 8-byte aligned")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    writer(d, bytes.data(), count);
+    return Napi::Number::New(env, static_cast<double>(size));
+}
+
+Napi::Value Document::toMsgPack(const Napi::CallbackInfo& i)
+{
+    auto env = i.Env();
+    if (checkBusy(env))
+        return env.Undefined();
+
+    try {
+        std::vector<char> out;
+        MsgPackWriter writer{out};
+        writer(self_.get());
+        return moveToBuffer(env, std::move(out));
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+Napi::Value Document::toCbor(const Napi::CallbackInfo& i)
+{
+    auto env = i.Env();
+    if (checkBusy(env))
+        return env.Undefined();
+
+    try {
+        std::vector<char> out;
+        CborWriter writer{out};
+        writer(self_.get());
+        return moveToBuffer(env, std::move(out));
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+Napi::Value Document::fromMsgPack(const Napi::CallbackInfo& i)
+{
+    auto env = i.Env();
+    if ((i.Length() < 1) || !i[0].IsBuffer())
+    {
+        Napi::TypeError::New(env, "argument must be a buffer")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto buffer = i[0].As<Napi::Buffer<char>>();
+    auto documentInstance = ctor.New({});
+    auto doc = Napi::ObjectWrap<Document>::Unwrap(documentInstance);
+    try {
+        // DOM строится через интерфейс SAX без промежуточного json
+        MsgPackReader reader{buffer.Data(), buffer.Length()};
+        if (!doc->self_.populate(reader))
+        {
+            Napi::Error::New(env, "invalid msgpack offset:" + 
+                std::to_string(reader.offset())).ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    return documentInstance;
+}
+
 void Document::Init(Napi::Env env, Napi::Object exports)
 {
     auto className = "Document";
@@ -130,8 +392,14 @@ void Document::Init(Napi::Env env, Napi::Object exports)
         InstanceMethod("parseOffset", &Document::parseOffset),
         InstanceMethod("parseMessage", &Document::parseMessage),
         InstanceMethod("parse", &Document::parse),
+        InstanceMethod("parseFile", &Document::parseFile),
         InstanceMethod("getResult", &Document::getResult),
-        InstanceMethod("get", &Document::getResult)
+        InstanceMethod("get", &Document::getResult),
+        InstanceMethod("tapeSize", &Document::tapeSize),
+        InstanceMethod("toTape", &Document::toTape),
+        InstanceMethod("toMsgPack", &Document::toMsgPack),
+        InstanceMethod("toCbor", &Document::toCbor),
+        StaticMethod("fromMsgPack", &Document::fromMsgPack)
     });
     ctor = Napi::Persistent(func);
     ctor.SuppressDestruct();
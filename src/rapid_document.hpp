@@ -4,10 +4,18 @@
 
 namespace rapid {
 
+class ParseFileWorker;
+
 class Document final
     : public Napi::ObjectWrap<Document>
 {
     BasicDocument self_;
+    // документ разбирается в другом потоке
+    bool busy_{false};
+
+    friend class ParseFileWorker;
+
+    bool checkBusy(Napi::Env env) const;
 
 public:
     static Napi::FunctionReference ctor;
@@ -24,6 +32,13 @@ public:
 
     Napi::Value parse(const Napi::CallbackInfo& i);
 
+    Napi::Value parseFile(const Napi::CallbackInfo& i);
+
+    bool busy() const noexcept
+    {
+        return busy_;
+    }
+
     bool empty() const noexcept
     {
         return self_.empty();
@@ -31,13 +46,7 @@ public:
 
     bool parserError() const noexcept
     {
-        if (!empty())
-        {
-            auto& d = static_cast<const rapidjson::Document&>(self_);
-            return d.HasParseError();
-        }
-
-        return false;
+        return !empty() && self_.hasParseError();
     }
 
     operator rapidjson::Document&() noexcept
@@ -58,6 +67,16 @@ public:
     Napi::Value getResult(const Napi::CallbackInfo& i);
 
     Napi::Value getResult(Napi::Env& env, Napi::Array& pointer, std::size_t level) const;
+
+    Napi::Value tapeSize(const Napi::CallbackInfo& i);
+
+    Napi::Value toTape(const Napi::CallbackInfo& i);
+
+    Napi::Value toMsgPack(const Napi::CallbackInfo& i);
+
+    Napi::Value toCbor(const Napi::CallbackInfo& i);
+
+    static Napi::Value fromMsgPack(const Napi::CallbackInfo& i);
     
     static void Init(Napi::Env env, Napi::Object exports);
 };    
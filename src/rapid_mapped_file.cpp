@@ -0,0 +1,155 @@
+#include "rapid_mapped_file.hpp"
+#include <stdexcept>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rapid {
+
+// у каналов, устройств и файлов /proc размер неизвестен
+static std::runtime_error notRegular(const std::string& path)
+{
+    return std::runtime_error(path + ": not a regular file");
+}
+
+#ifdef _WIN32
+
+static std::system_error lastError(const std::string& path)
+{
+    return std::system_error(static_cast<int>(GetLastError()), 
+        std::system_category(), path);
+}
+
+MappedFile::MappedFile(const std::string& path)
+{
+    // путь приходит из js в utf-8
+    auto length = MultiByteToWideChar(CP_UTF8, 0, 
+        path.data(), static_cast<int>(path.size()), nullptr, 0);
+    std::wstring wpath(static_cast<std::size_t>(length), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, 
+        path.data(), static_cast<int>(path.size()), wpath.data(), length);
+
+    auto file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, 
+        nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw lastError(path);
+
+    if (GetFileType(file) != FILE_TYPE_DISK)
+    {
+        CloseHandle(file);
+        throw notRegular(path);
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        auto e = lastError(path);
+        CloseHandle(file);
+        throw e;
+    }
+
+    size_ = static_cast<std::size_t>(size.QuadPart);
+    if (size_)
+    {
+        auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            auto e = lastError(path);
+            CloseHandle(file);
+            throw e;
+        }
+
+        // представление держит отображение, хэндлы можно закрыть
+        auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        auto e = lastError(path);
+        CloseHandle(mapping);
+        CloseHandle(file);
+        if (!view)
+            throw e;
+
+        data_ = static_cast<const char*>(view);
+        return;
+    }
+
+    CloseHandle(file);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data_)
+        UnmapViewOfFile(data_);
+}
+
+#else
+
+static std::system_error lastError(const std::string& path)
+{
+    return std::system_error(errno, std::generic_category(), path);
+}
+
+MappedFile::MappedFile(const std::string& path)
+{
+    auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw lastError(path);
+
+    struct stat st;
+    if (::fstat(fd, &st) < 0)
+    {
+        auto e = lastError(path);
+        ::close(fd);
+        throw e;
+    }
+
+    if (!S_ISREG(st.st_mode))
+    {
+        ::close(fd);
+        throw notRegular(path);
+    }
+
+    size_ = static_cast<std::size_t>(st.st_size);
+    // файлы /proc и sysfs обычные, но с нулевым размером при наличии данных
+    char probe;
+    if (!size_ && (::read(fd, &probe, 1) > 0))
+    {
+        ::close(fd);
+        throw notRegular(path);
+    }
+    if (size_)
+    {
+        auto p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            auto e = lastError(path);
+            ::close(fd);
+            throw e;
+        }
+        // читаем один раз от начала до конца
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(p);
+    }
+
+    // отображение остается валидным после закрытия дескриптора
+    ::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data_)
+        ::munmap(const_cast<char*>(data_), size_);
+}
+
+#endif
+
+} // namespace rapid
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace rapid {
+
+// файл отображенный в память только для чтения
+// при ошибке бросает std::system_error
+class MappedFile final
+{
+    const char* data_{};
+    std::size_t size_{};
+
+public:
+    explicit MappedFile(const std::string& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const noexcept
+    {
+        return data_;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+};
+
+} // namespace rapid
@@ -1,10 +1,14 @@
 #include "rapid_schema.hpp"
 #include "rapid_document.hpp"
+#include "rapid_tape_view.hpp"
+#include "rapid_array_iterator.hpp"
 
 // Инициализация модуля
 Napi::Object InitAll(Napi::Env env, Napi::Object exports) {
     rapid::Document::Init(env, exports);
     rapid::Schema::Init(env, exports);
+    rapid::TapeView::Init(env, exports);
+    rapid::ArrayIterator::Init(env, exports);
     return exports;
 }
 
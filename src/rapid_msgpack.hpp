@@ -0,0 +1,358 @@
+#pragma once
+
+#include "rapid_type.hpp"
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace rapid {
+
+// глубина вложенности при разборе msgpack
+constexpr auto msgpack_max_depth = std::size_t{1024u};
+
+// кодирует rapidjson::Value в msgpack
+// uint64 и int64 сохраняются как есть, без потери точности
+class MsgPackWriter final
+{
+    std::vector<char>& out_;
+
+    void put(std::uint8_t c)
+    {
+        out_.push_back(static_cast<char>(c));
+    }
+
+    // big-endian
+    template<class T>
+    void put(std::uint8_t tag, T val)
+    {
+        static_assert(std::is_unsigned_v<T>);
+        put(tag);
+        for (auto i = sizeof(T); i--; )
+            put(static_cast<std::uint8_t>(val >> (i * 8)));
+    }
+
+    void uint(std::uint64_t val)
+    {
+        if (val <= 0x7f) {
+            put(static_cast<std::uint8_t>(val));
+        } else if (val <= std::numeric_limits<std::uint8_t>::max()) {
+            put(0xcc, static_cast<std::uint8_t>(val));
+        } else if (val <= std::numeric_limits<std::uint16_t>::max()) {
+            put(0xcd, static_cast<std::uint16_t>(val));
+        } else if (val <= std::numeric_limits<std::uint32_t>::max()) {
+            put(0xce, static_cast<std::uint32_t>(val));
+        } else {
+            put(0xcf, val);
+        }
+    }
+
+    void int64(std::int64_t val)
+    {
+        if (val >= -32) {
+            put(static_cast<std::uint8_t>(val));
+        } else if (val >= std::numeric_limits<std::int8_t>::min()) {
+            put(0xd0, static_cast<std::uint8_t>(val));
+        } else if (val >= std::numeric_limits<std::int16_t>::min()) {
+            put(0xd1, static_cast<std::uint16_t>(val));
+        } else if (val >= std::numeric_limits<std::int32_t>::min()) {
+            put(0xd2, static_cast<std::uint32_t>(val));
+        } else {
+            put(0xd3, static_cast<std::uint64_t>(val));
+        }
+    }
+
+    void string(const char* str, std::uint32_t length)
+    {
+        if (length < 32) {
+            put(static_cast<std::uint8_t>(0xa0 | length));
+        } else if (length <= std::numeric_limits<std::uint8_t>::max()) {
+            put(0xd9, static_cast<std::uint8_t>(length));
+        } else if (length <= std::numeric_limits<std::uint16_t>::max()) {
+            put(0xda, static_cast<std::uint16_t>(length));
+        } else {
+            put(0xdb, length);
+        }
+        out_.insert(out_.end(), str, str + length);
+    }
+
+    void container(std::uint8_t fix, std::uint8_t tag, std::uint32_t size)
+    {
+        if (size < 16) {
+            put(static_cast<std::uint8_t>(fix | size));
+        } else if (size <= std::numeric_limits<std::uint16_t>::max()) {
+            put(tag, static_cast<std::uint16_t>(size));
+        } else {
+            put(tag + 1, size);
+        }
+    }
+
+public:
+    explicit MsgPackWriter(std::vector<char>& out) noexcept
+        : out_{out}
+    {   }
+
+    void operator()(const rapidjson::Value& value)
+    {
+        switch (value.GetType()) {
+            case rapidjson::kNullType:
+                put(0xc0);
+                break;
+            case rapidjson::kFalseType:
+                put(0xc2);
+                break;
+            case rapidjson::kTrueType:
+                put(0xc3);
+                break;
+            case rapidjson::kObjectType:
+                container(0x80, 0xde, value.MemberCount());
+                for (auto& m : value.GetObject())
+                {
+                    string(m.name.GetString(), m.name.GetStringLength());
+                    (*this)(m.value);
+                }
+                break;
+            case rapidjson::kArrayType:
+                container(0x90, 0xdc, value.Size());
+                for (auto& v : value.GetArray())
+                    (*this)(v);
+                break;
+            case rapidjson::kStringType:
+                string(value.GetString(), value.GetStringLength());
+                break;
+            case rapidjson::kNumberType:
+                if (value.IsUint64()) {
+                    uint(value.GetUint64());
+                } else if (value.IsInt64()) {
+                    int64(value.GetInt64());
+                } else {
+                    auto d = value.GetDouble();
+                    std::uint64_t bits;
+                    std::memcpy(&bits, &d, sizeof(d));
+                    put(0xcb, bits);
+                }
+                break;
+            default: ;
+        }
+    }
+};
+
+// разбирает msgpack и генерирует события SAX
+// используется как генератор для rapidjson::Document::Populate
+class MsgPackReader final
+{
+    const std::uint8_t* begin_{};
+    const std::uint8_t* p_{};
+    const std::uint8_t* end_{};
+
+    // big-endian
+    template<class T>
+    bool get(T& val) noexcept
+    {
+        if (static_cast<std::size_t>(end_ - p_) < sizeof(T))
+            return false;
+        val = 0;
+        for (auto i = 0u; i < sizeof(T); ++i)
+            val = static_cast<T>((val << 8) | *p_++);
+        return true;
+    }
+
+    template<class T, class H>
+    bool uint(H& handler) noexcept
+    {
+        T val;
+        return get(val) && handler.Uint64(val);
+    }
+
+    template<class T, class H>
+    bool int64(H& handler) noexcept
+    {
+        std::make_unsigned_t<T> val;
+        if (!get(val))
+            return false;
+        auto i = static_cast<std::int64_t>(static_cast<T>(val));
+        return (i < 0) ? handler.Int64(i) : 
+            handler.Uint64(static_cast<std::uint64_t>(i));
+    }
+
+    template<class T>
+    bool length(std::uint32_t& size) noexcept
+    {
+        T val;
+        if (!get(val))
+            return false;
+        size = val;
+        return true;
+    }
+
+    bool string(std::uint32_t size, const char*& str) noexcept
+    {
+        if (static_cast<std::size_t>(end_ - p_) < size)
+            return false;
+        str = reinterpret_cast<const char*>(p_);
+        p_ += size;
+        return true;
+    }
+
+    template<class H>
+    bool string(H& handler, std::uint32_t size, bool key) noexcept
+    {
+        const char* str;
+        if (!string(size, str))
+            return false;
+        return key ? handler.Key(str, size, true) : 
+            handler.String(str, size, true);
+    }
+
+    // ключ объекта должен быть строкой
+    template<class H>
+    bool key(H& handler) noexcept
+    {
+        if (p_ == end_)
+            return false;
+        std::uint32_t size;
+        auto c = *p_++;
+        if ((c & 0xe0) == 0xa0) {
+            size = c & 0x1f;
+        } else if (c == 0xd9) {
+            if (!length<std::uint8_t>(size))
+                return false;
+        } else if (c == 0xda) {
+            if (!length<std::uint16_t>(size))
+                return false;
+        } else if (c == 0xdb) {
+            if (!length<std::uint32_t>(size))
+                return false;
+        } else {
+            return false;
+        }
+        return string(handler, size, true);
+    }
+
+    template<class H>
+    bool object(H& handler, std::uint32_t size, std::size_t depth)
+    {
+        if (!handler.StartObject())
+            return false;
+        for (std::uint32_t i = 0; i < size; ++i)
+        {
+            if (!(key(handler) && value(handler, depth + 1)))
+                return false;
+        }
+        return handler.EndObject(size);
+    }
+
+    template<class H>
+    bool array(H& handler, std::uint32_t size, std::size_t depth)
+    {
+        if (!handler.StartArray())
+            return false;
+        for (std::uint32_t i = 0; i < size; ++i)
+        {
+            if (!value(handler, depth + 1))
+                return false;
+        }
+        return handler.EndArray(size);
+    }
+
+    template<class H>
+    bool value(H& handler, std::size_t depth)
+    {
+        if ((p_ == end_) || (depth > msgpack_max_depth))
+            return false;
+
+        std::uint32_t size;
+        auto c = *p_++;
+        if (c <= 0x7f)
+            return handler.Uint64(c);
+        if (c >= 0xe0)
+            return handler.Int64(static_cast<std::int8_t>(c));
+        if ((c & 0xf0) == 0x80)
+            return object(handler, c & 0x0f, depth);
+        if ((c & 0xf0) == 0x90)
+            return array(handler, c & 0x0f, depth);
+        if ((c & 0xe0) == 0xa0)
+            return string(handler, c & 0x1f, false);
+
+        switch (c) {
+            case 0xc0:
+                return handler.Null();
+            case 0xc2:
+                return handler.Bool(false);
+            case 0xc3:
+                return handler.Bool(true);
+            case 0xca: {
+                std::uint32_t bits;
+                if (!get(bits))
+                    return false;
+                float f;
+                std::memcpy(&f, &bits, sizeof(f));
+                return handler.Double(f);
+            }
+            case 0xcb: {
+                std::uint64_t bits;
+                if (!get(bits))
+                    return false;
+                double d;
+                std::memcpy(&d, &bits, sizeof(d));
+                return handler.Double(d);
+            }
+            case 0xcc:
+                return uint<std::uint8_t>(handler);
+            case 0xcd:
+                return uint<std::uint16_t>(handler);
+            case 0xce:
+                return uint<std::uint32_t>(handler);
+            case 0xcf:
+                return uint<std::uint64_t>(handler);
+            case 0xd0:
+                return int64<std::int8_t>(handler);
+            case 0xd1:
+                return int64<std::int16_t>(handler);
+            case 0xd2:
+                return int64<std::int32_t>(handler);
+            case 0xd3:
+                return int64<std::int64_t>(handler);
+            case 0xd9:
+                return length<std::uint8_t>(size) && string(handler, size, false);
+            case 0xda:
+                return length<std::uint16_t>(size) && string(handler, size, false);
+            case 0xdb:
+                return length<std::uint32_t>(size) && string(handler, size, false);
+            case 0xdc:
+                return length<std::uint16_t>(size) && array(handler, size, depth);
+            case 0xdd:
+                return length<std::uint32_t>(size) && array(handler, size, depth);
+            case 0xde:
+                return length<std::uint16_t>(size) && object(handler, size, depth);
+            case 0xdf:
+                return length<std::uint32_t>(size) && object(handler, size, depth);
+            default: ;
+        }
+        // bin, ext и зарезервированные типы в json не отображаются
+        return false;
+    }
+
+public:
+    MsgPackReader(const char* data, std::size_t size) noexcept
+        : begin_{reinterpret_cast<const std::uint8_t*>(data)}
+        , p_{begin_}
+        , end_{begin_ + size}
+    {   }
+
+    template<class H>
+    bool operator()(H& handler)
+    {
+        p_ = begin_;
+        // после значения данных быть не должно
+        return value(handler, 0) && (p_ == end_);
+    }
+
+    // позиция на которой остановился разбор
+    std::size_t offset() const noexcept
+    {
+        return static_cast<std::size_t>(p_ - begin_);
+    }
+};
+
+} // namespace rapid
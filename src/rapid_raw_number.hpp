@@ -0,0 +1,200 @@
+#pragma once
+
+#include "rapid_type.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace rapid {
+
+// исходный текст чисел которые попали в DOM как double
+// целые вне 64 бит и дроби для decimal-string, в порядке разбора
+// у остальных double пустой текст, он только держит позицию
+// DOM обходится в том же порядке, поэтому номер double в обходе
+// совпадает с номером текста
+class RawNumbers final
+{
+    std::string text_;
+    std::vector<std::pair<std::size_t, std::size_t>> span_;
+
+public:
+    void clear() noexcept
+    {
+        text_.clear();
+        span_.clear();
+    }
+
+    void push(std::string_view text)
+    {
+        span_.emplace_back(text_.size(), text.size());
+        text_.append(text);
+    }
+
+    // double без текста
+    void skip()
+    {
+        span_.emplace_back(text_.size(), 0);
+    }
+
+    std::size_t size() const noexcept
+    {
+        return span_.size();
+    }
+
+    std::string_view operator[](std::size_t i) const noexcept
+    {
+        auto& [offset, length] = span_[i];
+        return {text_.data() + offset, length};
+    }
+};
+
+// позиция в RawNumbers на время одного обхода DOM
+struct RawCursor final
+{
+    const RawNumbers* raw{};
+    std::size_t next{};
+
+    // пустая строка если текста нет
+    std::string_view take() noexcept
+    {
+        return (raw && (next < raw->size())) ?
+            (*raw)[next++] : std::string_view{};
+    }
+};
+
+// целое записанное без точки и экспоненты
+inline bool isIntegerText(std::string_view text) noexcept
+{
+    return text.find_first_of(".eE") == std::string_view::npos;
+}
+
+// модуль целого из десятичной записи словами по 64 бита, младшие первыми
+// знак и ведущие нули пропускаются
+inline std::vector<std::uint64_t> integerWords(std::string_view text)
+{
+    // считаем в 32 битных словах, произведение помещается в 64 бита
+    std::vector<std::uint32_t> limb;
+    for (auto c : text)
+    {
+        if ((c < '0') || (c > '9'))
+            continue;
+        auto carry = static_cast<std::uint64_t>(c - '0');
+        for (auto& l : limb)
+        {
+            auto v = std::uint64_t{l} * 10u + carry;
+            l = static_cast<std::uint32_t>(v);
+            carry = v >> 32;
+        }
+        if (carry)
+            limb.push_back(static_cast<std::uint32_t>(carry));
+    }
+
+    std::vector<std::uint64_t> words((limb.size() + 1) / 2);
+    for (std::size_t n = 0; n < limb.size(); ++n)
+        words[n / 2] |= std::uint64_t{limb[n]} << ((n % 2) * 32);
+    return words;
+}
+
+// обработчик для разбора с kParseNumbersAsStringsFlag
+// решает по тексту числа: целые в 64 битах идут в DOM как Int64/Uint64,
+// остальные как double, текст сохраняется если он понадобится
+template<class H>
+class RawNumberHandler final
+{
+    H& handler_;
+    RawNumbers& raw_;
+    // текст дробей нужен только для decimal-string
+    bool decimal_{};
+    bool tooBig_{};
+
+public:
+    typedef char Ch;
+
+    RawNumberHandler(H& handler, RawNumbers& raw, bool decimal) noexcept
+        : handler_{handler}
+        , raw_{raw}
+        , decimal_{decimal}
+    {   }
+
+    // разбор прерван числом вне диапазона double
+    bool numberTooBig() const noexcept
+    {
+        return tooBig_;
+    }
+
+    bool RawNumber(const Ch* str, rapidjson::SizeType length, bool)
+    {
+        auto end = str + length;
+        auto integer = isIntegerText({str, length});
+        if (integer)
+        {
+            if (*str == '-') {
+                std::int64_t val;
+                auto rc = std::from_chars(str, end, val);
+                if ((rc.ec == std::errc()) && (rc.ptr == end))
+                    return handler_.Int64(val);
+            } else {
+                std::uint64_t val;
+                auto rc = std::from_chars(str, end, val);
+                if ((rc.ec == std::errc()) && (rc.ptr == end))
+                    return handler_.Uint64(val);
+            }
+        }
+
+        // from_chars округляет корректно, как kParseFullPrecisionFlag
+        double d;
+        auto rc = std::from_chars(str, end, d);
+        if (rc.ec == std::errc::result_out_of_range) {
+            // исчезающе малые как у rapidjson становятся нулем
+            // слишком большие это ошибка
+            d = std::strtod(std::string{str, length}.c_str(), nullptr);
+            if (std::isinf(d))
+            {
+                tooBig_ = true;
+                return false;
+            }
+        } else if ((rc.ec != std::errc()) || (rc.ptr != end)) {
+            tooBig_ = true;
+            return false;
+        }
+
+        if (integer || decimal_) {
+            raw_.push({str, length});
+        } else {
+            raw_.skip();
+        }
+        return handler_.Double(d);
+    }
+
+    bool Null() { return handler_.Null(); }
+    bool Bool(bool b) { return handler_.Bool(b); }
+    bool Int(int i) { return handler_.Int(i); }
+    bool Uint(unsigned u) { return handler_.Uint(u); }
+    bool Int64(std::int64_t i) { return handler_.Int64(i); }
+    bool Uint64(std::uint64_t u) { return handler_.Uint64(u); }
+    bool Double(double d) { return handler_.Double(d); }
+
+    bool String(const Ch* str, rapidjson::SizeType length, bool copy)
+    {
+        return handler_.String(str, length, copy);
+    }
+
+    bool StartObject() { return handler_.StartObject(); }
+
+    bool Key(const Ch* str, rapidjson::SizeType length, bool copy)
+    {
+        return handler_.Key(str, length, copy);
+    }
+
+    bool EndObject(rapidjson::SizeType count) { return handler_.EndObject(count); }
+    bool StartArray() { return handler_.StartArray(); }
+    bool EndArray(rapidjson::SizeType count) { return handler_.EndArray(count); }
+};
+
+} // namespace rapid
@@ -1,4 +1,5 @@
 #include "rapid_schema.hpp"
+#include "rapid_value_reader.hpp"
 //#include <iostream>
 
 namespace rapid {
@@ -41,8 +42,7 @@ Napi::Value Schema::parse(const Napi::CallbackInfo& i)
     return Napi::Boolean::New(env, false); 
 }
 
-void Schema::saveLastError(const rapidjson::SchemaValidator& validator, 
-    const rapidjson::Document& scheme, const rapidjson::Document& document) 
+void Schema::saveLastError(const rapidjson::SchemaValidator& validator) 
 {
     validateKeyword_ = validator.GetInvalidSchemaKeyword();
 
@@ -92,12 +92,53 @@ Napi::Value Schema::validate(const Napi::CallbackInfo& i)
         return env.Undefined();
     }
 
-    validator_->Reset();
     // теперь мы точно знаем что это документ
     auto doc = Napi::ObjectWrap<Document>::Unwrap(someObject);
+    if (doc->busy())
+    {
+        Napi::Error::New(env, "document is busy")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    validator_->Reset();
     auto result = doc->Accept(*validator_);
     if (!result)
-        saveLastError(*validator_, schemaDoc(), *doc);
+        saveLastError(*validator_);
+
+    return Napi::Boolean::New(env, result);
+}
+
+Napi::Value Schema::validateValue(const Napi::CallbackInfo& i)
+{
+    auto env = i.Env();
+    if (!(self_ && validator_))
+    {
+        Napi::TypeError::New(env, "missing schema")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    if (i.Length() < 1)
+    {
+        Napi::TypeError::New(env, "missing argument")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    validator_->Reset();
+    // события SAX идут прямо в валидатор, без json и DOM
+    ValueReader reader{i[0]};
+    auto result = reader(*validator_);
+    if (!reader.error().empty())
+    {
+        Napi::TypeError::New(env, reader.error())
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    if (!result)
+        saveLastError(*validator_);
 
     return Napi::Boolean::New(env, result);
 }
@@ -114,7 +155,8 @@ void Schema::Init(Napi::Env env, Napi::Object exports)
         InstanceMethod("validateKeyword", &Schema::validateKeyword),
         InstanceMethod("documentPointer", &Schema::documentPointer),
         InstanceMethod("parse", &Schema::parse),
-        InstanceMethod("validate", &Schema::validate)
+        InstanceMethod("validate", &Schema::validate),
+        InstanceMethod("validateValue", &Schema::validateValue)
     });
 
     ctor = Napi::Persistent(func);
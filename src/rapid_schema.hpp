@@ -24,8 +24,7 @@ class Schema final
         return *Napi::ObjectWrap<Document>::Unwrap(docRef_.Value());
     }
 
-    void saveLastError(const rapidjson::SchemaValidator& validator, 
-        const rapidjson::Document& scheme, const rapidjson::Document& document);
+    void saveLastError(const rapidjson::SchemaValidator& validator);
 
 public:
     static Napi::FunctionReference ctor;
@@ -58,6 +57,8 @@ public:
 
     Napi::Value validate(const Napi::CallbackInfo& i);
 
+    Napi::Value validateValue(const Napi::CallbackInfo& i);
+
     Napi::Value schemaPointer(const Napi::CallbackInfo& i)
     {
         return Napi::String::New(i.Env(), schemaPointer_);
@@ -0,0 +1,517 @@
+#pragma once
+
+#include "rapid_type.hpp"
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace rapid {
+
+// лента это плоское представление DOM
+// [TapeHeader][TapeNode x nodeCount][строки x stringSize]
+// узлы идут в прямом порядке обхода, у объекта за заголовком
+// следуют пары ключ-значение, у массива элементы
+constexpr auto tape_magic = std::uint32_t{0x50544a52u}; // "RJTP"
+constexpr auto tape_version = std::uint32_t{1u};
+
+// первые теги совпадают с rapidjson::Type
+enum TapeTag : std::uint32_t
+{
+    kTapeNull = rapidjson::kNullType,
+    kTapeFalse = rapidjson::kFalseType,
+    kTapeTrue = rapidjson::kTrueType,
+    kTapeObject = rapidjson::kObjectType,
+    kTapeArray = rapidjson::kArrayType,
+    kTapeString = rapidjson::kStringType,
+    kTapeUint64 = rapidjson::kNumberType,
+    kTapeInt64,
+    kTapeDouble
+};
+
+struct TapeHeader final
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t nodeCount;
+    std::uint64_t stringSize;
+    std::uint64_t reserved;
+};
+
+struct TapeNode final
+{
+    // TapeTag
+    std::uint32_t tag;
+    // длина строки или число элементов контейнера
+    std::uint32_t size;
+    // биты числа, смещение строки или индекс узла за контейнером
+    std::uint64_t data;
+};
+
+static_assert(sizeof(TapeHeader) == 32);
+static_assert(sizeof(TapeNode) == 16);
+
+class TapeWriter final
+{
+    TapeNode* node_{};
+    char* str_{};
+    std::size_t index_{};
+    std::size_t offset_{};
+
+    static void count(const rapidjson::Value& value,
+        std::size_t& nodes, std::size_t& strings) noexcept
+    {
+        ++nodes;
+        switch (value.GetType()) {
+            case rapidjson::kObjectType:
+                for (auto& m : value.GetObject())
+                {
+                    ++nodes;
+                    strings += m.name.GetStringLength() + 1;
+                    count(m.value, nodes, strings);
+                }
+                break;
+            case rapidjson::kArrayType:
+                for (auto& v : value.GetArray())
+                    count(v, nodes, strings);
+                break;
+            case rapidjson::kStringType:
+                strings += value.GetStringLength() + 1;
+                break;
+            default: ;
+        }
+    }
+
+    void string(TapeNode& node, const rapidjson::Value& value) noexcept
+    {
+        auto length = value.GetStringLength();
+        node.tag = kTapeString;
+        node.size = length;
+        node.data = offset_;
+        // строки храним с нулем, их можно отдавать как const char*
+        std::memcpy(str_ + offset_, value.GetString(), length);
+        str_[offset_ + length] = '\0';
+        offset_ += length + 1;
+    }
+
+    void write(const rapidjson::Value& value) noexcept
+    {
+        auto& node = node_[index_++];
+        node.size = 0;
+        node.data = 0;
+        switch (value.GetType()) {
+            case rapidjson::kObjectType:
+                node.tag = kTapeObject;
+                node.size = value.MemberCount();
+                for (auto& m : value.GetObject())
+                {
+                    string(node_[index_++], m.name);
+                    write(m.value);
+                }
+                node.data = index_;
+                break;
+            case rapidjson::kArrayType:
+                node.tag = kTapeArray;
+                node.size = value.Size();
+                for (auto& v : value.GetArray())
+                    write(v);
+                node.data = index_;
+                break;
+            case rapidjson::kStringType:
+                string(node, value);
+                break;
+            case rapidjson::kNumberType:
+                if (value.IsUint64()) {
+                    node.tag = kTapeUint64;
+                    node.data = value.GetUint64();
+                } else if (value.IsInt64()) {
+                    node.tag = kTapeInt64;
+                    node.data = static_cast<std::uint64_t>(value.GetInt64());
+                } else {
+                    auto d = value.GetDouble();
+                    node.tag = kTapeDouble;
+                    std::memcpy(&node.data, &d, sizeof(d));
+                }
+                break;
+            default:
+                node.tag = value.GetType();
+        }
+    }
+
+public:
+    // число узлов и байт строк, один проход по DOM
+    struct Count final
+    {
+        std::size_t nodes{};
+        std::size_t strings{};
+
+        // размер ленты в байтах
+        std::size_t size() const noexcept
+        {
+            return sizeof(TapeHeader) + nodes * sizeof(TapeNode) + strings;
+        }
+    };
+
+    static Count count(const rapidjson::Value& value) noexcept
+    {
+        Count result;
+        count(value, result.nodes, result.strings);
+        return result;
+    }
+
+    // размер ленты в байтах
+    static std::size_t size(const rapidjson::Value& value) noexcept
+    {
+        return count(value).size();
+    }
+
+    // data должен быть выровнен по TapeNode и вмещать c.size() байт
+    // c это результат count(value) для того же value
+    void operator()(const rapidjson::Value& value, void* data, 
+        const Count& c) noexcept
+    {
+        auto nodes = c.nodes;
+        auto strings = c.strings;
+
+        auto header = static_cast<TapeHeader*>(data);
+        header->magic = tape_magic;
+        header->version = tape_version;
+        header->nodeCount = nodes;
+        header->stringSize = strings;
+        header->reserved = 0;
+
+        node_ = reinterpret_cast<TapeNode*>(header + 1);
+        str_ = reinterpret_cast<char*>(node_ + nodes);
+        index_ = 0;
+        offset_ = 0;
+        write(value);
+    }
+};
+
+// лента не прошла проверку
+// буфер мог прийти извне или меняться другим потоком
+class TapeError final
+    : public std::runtime_error
+{
+public:
+    TapeError()
+        : std::runtime_error{"invalid tape"}
+    {   }
+};
+
+// узлы и строки ленты с их границами
+struct Tape final
+{
+    const TapeNode* node{};
+    std::size_t nodeCount{};
+    const char* str{};
+    std::size_t stringSize{};
+
+    // проверка заголовка, при ошибке TapeError
+    static Tape read(const char* data, std::size_t size)
+    {
+        TapeHeader header;
+        if ((data == nullptr) || (size < sizeof(header)) ||
+            (reinterpret_cast<std::uintptr_t>(data) % alignof(TapeNode)))
+            throw TapeError{};
+
+        // заголовок читаем один раз, он может меняться
+        std::memcpy(&header, data, sizeof(header));
+        auto nodes = (size - sizeof(header)) / sizeof(TapeNode);
+        if ((header.magic != tape_magic) || (header.version != tape_version) ||
+            (header.nodeCount == 0) || (header.nodeCount > nodes) ||
+            (header.stringSize > size - sizeof(header) - 
+                header.nodeCount * sizeof(TapeNode)))
+            throw TapeError{};
+
+        Tape tape;
+        tape.node = reinterpret_cast<const TapeNode*>(data + sizeof(header));
+        tape.nodeCount = static_cast<std::size_t>(header.nodeCount);
+        tape.str = reinterpret_cast<const char*>(tape.node + tape.nodeCount);
+        tape.stringSize = static_cast<std::size_t>(header.stringSize);
+        return tape;
+    }
+};
+
+struct TapeMember;
+
+template<class T>
+class TapeRange;
+
+// значение ленты с интерфейсом rapidjson::Value
+// достаточным для RapidConvert
+// узел копируется и проверяется при создании
+// поэтому конкурентная запись в буфер не выводит за его границы
+class TapeValue final
+{
+    const Tape* tape_{};
+    std::size_t index_{};
+    TapeNode node_{};
+
+public:
+    TapeValue() = default;
+
+    TapeValue(const Tape& tape, std::size_t index)
+        : tape_{&tape}
+        , index_{index}
+    {
+        if (index >= tape.nodeCount)
+            throw TapeError{};
+        std::memcpy(&node_, tape.node + index, sizeof(node_));
+
+        switch (node_.tag) {
+            case kTapeNull:
+            case kTapeFalse:
+            case kTapeTrue:
+            case kTapeUint64:
+            case kTapeInt64:
+            case kTapeDouble:
+                break;
+            case kTapeString:
+                // строка с завершающим нулем внутри таблицы строк
+                if ((node_.data >= tape.stringSize) || 
+                    (node_.size >= tape.stringSize - node_.data))
+                    throw TapeError{};
+                break;
+            case kTapeObject:
+            case kTapeArray: {
+                // конец контейнера строго дальше узла и не за лентой
+                // каждый элемент занимает хотя бы один узел, член объекта два
+                auto width = std::uint64_t{(node_.tag == kTapeObject) ? 2u : 1u};
+                if ((node_.data <= index) || (node_.data > tape.nodeCount) ||
+                    (node_.size * width > node_.data - index - 1))
+                    throw TapeError{};
+                break;
+            }
+            default:
+                throw TapeError{};
+        }
+    }
+
+    // индекс узла следующего за значением
+    std::size_t next() const noexcept
+    {
+        return ((node_.tag == kTapeObject) || (node_.tag == kTapeArray)) ?
+            static_cast<std::size_t>(node_.data) : index_ + 1;
+    }
+
+    rapidjson::Type GetType() const noexcept
+    {
+        return (node_.tag < kTapeUint64) ?
+            static_cast<rapidjson::Type>(node_.tag) : rapidjson::kNumberType;
+    }
+
+    bool IsObject() const noexcept
+    {
+        return node_.tag == kTapeObject;
+    }
+
+    bool IsArray() const noexcept
+    {
+        return node_.tag == kTapeArray;
+    }
+
+    bool IsUint64() const noexcept
+    {
+        return node_.tag == kTapeUint64;
+    }
+
+    bool IsInt64() const noexcept
+    {
+        return (node_.tag == kTapeInt64) || ((node_.tag == kTapeUint64) &&
+            (node_.data <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())));
+    }
+
+    bool IsUint() const noexcept
+    {
+        return IsUint64() && (GetUint64() <= std::numeric_limits<std::uint32_t>::max());
+    }
+
+    bool IsInt() const noexcept
+    {
+        if (!IsInt64())
+            return false;
+        auto val = GetInt64();
+        return (std::numeric_limits<std::int32_t>::min() <= val) &&
+            (val <= std::numeric_limits<std::int32_t>::max());
+    }
+
+    std::uint64_t GetUint64() const noexcept
+    {
+        return node_.data;
+    }
+
+    std::int64_t GetInt64() const noexcept
+    {
+        return static_cast<std::int64_t>(node_.data);
+    }
+
+    unsigned GetUint() const noexcept
+    {
+        return static_cast<unsigned>(node_.data);
+    }
+
+    int GetInt() const noexcept
+    {
+        return static_cast<int>(GetInt64());
+    }
+
+    double GetDouble() const noexcept
+    {
+        switch (node_.tag) {
+            case kTapeUint64:
+                return static_cast<double>(node_.data);
+            case kTapeInt64:
+                return static_cast<double>(static_cast<std::int64_t>(node_.data));
+            default: ;
+        }
+        double d;
+        std::memcpy(&d, &node_.data, sizeof(d));
+        return d;
+    }
+
+    // ключ объекта тоже должен быть строкой
+    const char* GetString() const
+    {
+        if (node_.tag != kTapeString)
+            throw TapeError{};
+        return tape_->str + node_.data;
+    }
+
+    rapidjson::SizeType GetStringLength() const noexcept
+    {
+        return node_.size;
+    }
+
+    rapidjson::SizeType Size() const noexcept
+    {
+        return node_.size;
+    }
+
+    rapidjson::SizeType MemberCount() const noexcept
+    {
+        return node_.size;
+    }
+
+    TapeRange<TapeMember> GetObject() const noexcept;
+
+    TapeRange<TapeValue> GetArray() const noexcept;
+
+    // поиск члена объекта, false если не найден
+    bool findMember(std::string_view key, TapeValue& result) const;
+
+    // поиск элемента массива, false если не найден
+    bool findElement(std::size_t index, TapeValue& result) const;
+};
+
+struct TapeMember final
+{
+    TapeValue name;
+    TapeValue value;
+};
+
+template<class T>
+class TapeRange final
+{
+    const Tape* tape_{};
+    std::size_t begin_{};
+    std::size_t end_{};
+
+public:
+    class iterator final
+    {
+        const Tape* tape_{};
+        std::size_t index_{};
+
+    public:
+        iterator(const Tape* tape, std::size_t index) noexcept
+            : tape_{tape}
+            , index_{index}
+        {   }
+
+        T operator*() const
+        {
+            if constexpr (std::is_same_v<T, TapeMember>) {
+                return TapeMember{{*tape_, index_}, {*tape_, index_ + 1}};
+            } else {
+                return TapeValue{*tape_, index_};
+            }
+        }
+
+        // next() всегда больше текущего индекса, цикл конечен
+        iterator& operator++()
+        {
+            // у члена объекта пропускаем ключ и значение
+            if constexpr (std::is_same_v<T, TapeMember>) {
+                index_ = TapeValue{*tape_, index_ + 1}.next();
+            } else {
+                index_ = TapeValue{*tape_, index_}.next();
+            }
+            return *this;
+        }
+
+        // элемент вышедший за конец контейнера завершает обход
+        bool operator!=(const iterator& other) const noexcept
+        {
+            return index_ < other.index_;
+        }
+    };
+
+    TapeRange(const Tape* tape, std::size_t begin, std::size_t end) noexcept
+        : tape_{tape}
+        , begin_{begin}
+        , end_{end}
+    {   }
+
+    iterator begin() const noexcept
+    {
+        return {tape_, begin_};
+    }
+
+    iterator end() const noexcept
+    {
+        return {tape_, end_};
+    }
+};
+
+inline TapeRange<TapeMember> TapeValue::GetObject() const noexcept
+{
+    return {tape_, index_ + 1, next()};
+}
+
+inline TapeRange<TapeValue> TapeValue::GetArray() const noexcept
+{
+    return {tape_, index_ + 1, next()};
+}
+
+inline bool TapeValue::findMember(std::string_view key, TapeValue& result) const
+{
+    for (auto&& [name, value] : GetObject())
+    {
+        if (key == std::string_view{name.GetString(), name.GetStringLength()})
+        {
+            result = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool TapeValue::findElement(std::size_t index, TapeValue& result) const
+{
+    if (index >= Size())
+        return false;
+    auto i = std::size_t{};
+    for (auto&& value : GetArray())
+    {
+        if (i++ == index)
+        {
+            result = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace rapid
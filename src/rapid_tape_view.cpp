@@ -0,0 +1,210 @@
+#include "rapid_tape_view.hpp"
+#include "rapid_convert.hpp"
+#include "rapid_basic_document.hpp"
+#include <charconv>
+#include <string>
+
+namespace rapid {
+
+Napi::FunctionReference TapeView::ctor{};
+
+std::span<char> tapeBytes(const Napi::Value& value)
+{
+    auto env = value.Env();
+    if (value.IsArrayBuffer())
+    {
+        auto buffer = value.As<Napi::ArrayBuffer>();
+        return {static_cast<char*>(buffer.Data()), buffer.ByteLength()};
+    }
+
+    if (value.IsTypedArray())
+    {
+        // у SharedArrayBuffer нет napi_get_arraybuffer_info
+        // поэтому берем данные напрямую из типизированного массива
+        napi_typedarray_type type;
+        std::size_t length;
+        void* data;
+        auto status = napi_get_typedarray_info(env, value, 
+            &type, &length, &data, nullptr, nullptr);
+        NAPI_THROW_IF_FAILED(env, status, std::span<char>{});
+        if (type == napi_uint8_array)
+            return {static_cast<char*>(data), length};
+    }
+
+    Napi::TypeError::New(env, "argument must be an ArrayBuffer or an Uint8Array")
+        .ThrowAsJavaScriptException();
+    return {};
+}
+
+TapeView::TapeView(const Napi::CallbackInfo& i)
+    : ObjectWrap{i}
+{
+    auto env = i.Env();
+    if (i.Length() < 1)
+    {
+        Napi::TypeError::New(env, "missing argument")
+            .ThrowAsJavaScriptException();
+        return;
+    }
+
+    try {
+        policy_ = getNumberPolicy(i);
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return;
+    }
+
+    auto bytes = tapeBytes(i[0]);
+    if (bytes.data() == nullptr)
+        return;
+
+    try {
+        Tape::read(bytes.data(), bytes.size());
+    } catch (const TapeError& e) {
+        Napi::TypeError::New(env, e.what())
+            .ThrowAsJavaScriptException();
+        return;
+    }
+
+    // держим буфер пока жив view
+    bufferRef_ = Napi::Persistent(i[0].As<Napi::Object>());
+}
+
+TapeView::~TapeView()
+{
+    bufferRef_.Reset();
+}
+
+Napi::Value TapeView::get(const Napi::CallbackInfo& i)
+{
+    auto env = i.Env();
+    if (bufferRef_.IsEmpty())
+    {
+        Napi::TypeError::New(env, "missing tape")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto bytes = tapeBytes(bufferRef_.Value());
+    if (env.IsExceptionPending())
+        return env.Undefined();
+
+    // отсоединенный ArrayBuffer не имеет данных
+    if ((bytes.data() == nullptr) || bytes.empty())
+    {
+        Napi::Error::New(env, "tape buffer is detached")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    std::string path;
+    if (i.Length() > 0)
+    {
+        auto& arg0 = i[0];
+        if (arg0.IsString()) {
+            path = arg0.As<Napi::String>().Utf8Value();
+        } else if (!arg0.IsUndefined()) {
+            Napi::TypeError::New(env, "pointer must be a string")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+    }
+
+    // пути как у RapidPointer, # в начале необязателен
+    std::string_view p{path};
+    if (!p.empty() && (p.front() == '#'))
+        p.remove_prefix(1);
+    if (!p.empty() && (p.front() != '/'))
+    {
+        Napi::TypeError::New(env, "pointer must start with /")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    // заголовок и каждый узел проверяются при чтении
+    try {
+        auto tape = Tape::read(bytes.data(), bytes.size());
+        return get(env, tape, p, i);
+    } catch (const TapeError& e) {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+Napi::Value TapeView::get(Napi::Env env, const Tape& tape, 
+    std::string_view p, const Napi::CallbackInfo& i) const
+{
+    // считаем уровень и хэш так же как RapidConvert при полном обходе
+    // тогда правила BigInt для поддерева совпадают с Document::getResult
+    constexpr fnv1a hf;
+    fnv1a hash{hf("#")};
+    std::size_t level = 0;
+    TapeValue value{tape, 0};
+    std::string key;
+    while (!p.empty())
+    {
+        p.remove_prefix(1);
+        auto pos = p.find('/');
+        auto token = p.substr(0, pos);
+        p = (pos == std::string_view::npos) ? std::string_view{} : p.substr(pos);
+
+        // ~1 это /, ~0 это ~
+        key.clear();
+        for (std::size_t n = 0; n < token.size(); ++n)
+        {
+            if ((token[n] == '~') && (n + 1 < token.size()) &&
+                ((token[n + 1] == '0') || (token[n + 1] == '1')))
+            {
+                key += (token[++n] == '0') ? '~' : '/';
+            } else {
+                key += token[n];
+            }
+        }
+
+        auto found = false;
+        auto slash = fnv1a{hash("/")};
+        if (value.IsObject()) {
+            found = value.findMember(key, value);
+            hash = fnv1a{slash(key.data(), key.size())};
+        } else if (value.IsArray()) {
+            std::size_t index;
+            auto end = key.data() + key.size();
+            auto rc = std::from_chars(key.data(), end, index);
+            found = !key.empty() && (rc.ec == std::errc()) && (rc.ptr == end) &&
+                value.findElement(index, value);
+            hash = fnv1a{slash("*")};
+        }
+
+        if (!found)
+            return env.Undefined();
+        ++level;
+    }
+
+    auto pointer = Napi::Array::New(env, 0);
+    if (i.Length() > 1)
+    {
+        auto& arg1 = i[1];
+        // arg1 это RapidPointer со свойством pointer типа Array
+        if (arg1.IsObject())
+        {
+            auto obj = arg1.As<Napi::Object>();
+            pointer = obj.Get("pointer").As<Napi::Array>();
+        }
+    }
+
+    RapidConvert<TapeValue> f{env, pointer, level, hash, policy_};
+    return f(value);
+}
+
+void TapeView::Init(Napi::Env env, Napi::Object exports)
+{
+    auto className = "TapeView";
+    auto func = DefineClass(env, className, {
+        InstanceMethod("get", &TapeView::get)
+    });
+    ctor = Napi::Persistent(func);
+    ctor.SuppressDestruct();
+    exports.Set(className, func);
+}
+
+} // namespace rapid
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "rapid_tape.hpp"
+#include <span>
+
+namespace rapid {
+
+// байты ArrayBuffer или Uint8Array, в том числе поверх SharedArrayBuffer
+// при ошибке бросает исключение в js и возвращает пустой span
+std::span<char> tapeBytes(const Napi::Value& value);
+
+// навигация по ленте полученной из Document::toTape
+// буфер может прийти из другого потока
+class TapeView final
+    : public Napi::ObjectWrap<TapeView>
+{
+    // буфер может быть передан или отсоединен после создания view
+    // поэтому указатели на данные берутся заново при каждом get
+    Napi::ObjectReference bufferRef_;
+    NumberPolicy policy_{NumberPolicy::pointer};
+
+    Napi::Value get(Napi::Env env, const Tape& tape, 
+        std::string_view p, const Napi::CallbackInfo& i) const;
+
+public:
+    static Napi::FunctionReference ctor;
+
+    TapeView(const Napi::CallbackInfo& i);
+
+    ~TapeView();
+
+    Napi::Value get(const Napi::CallbackInfo& i);
+
+    static void Init(Napi::Env env, Napi::Object exports);
+};
+
+} // namespace rapid
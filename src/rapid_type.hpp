@@ -11,6 +11,19 @@ namespace rapid {
 
 constexpr auto number_max_safe = 9007199254740991u;
 
+// как числа json превращаются в значения js
+enum class NumberPolicy
+{
+    // BigInt только по RapidPointer
+    pointer,
+    // BigInt для целых вне Number.MAX_SAFE_INTEGER
+    bigintIfUnsafe,
+    // BigInt для всех целых
+    int64Bigint,
+    // как bigintIfUnsafe, дробные числа строкой без потери точности
+    decimalString
+};
+
 using PoolAllocatorType = 
     rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator>;
 
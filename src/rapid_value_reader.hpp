@@ -0,0 +1,268 @@
+#pragma once
+
+#include "rapid_type.hpp"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rapid {
+
+// глубина вложенности при обходе значения js
+constexpr auto value_max_depth = std::size_t{1024u};
+
+// обходит значение js и генерирует события SAX
+// правила как у JSON.stringify, BigInt становится Int64 или Uint64
+// обход прекращается как только обработчик вернет false
+class ValueReader final
+{
+    // обертки примитивов, JSON.stringify их разворачивает
+    enum Box { boxNumber, boxString, boxBoolean, boxBigInt, boxCount };
+
+    Napi::Value value_;
+    std::vector<napi_value> stack_;
+    std::string error_;
+    // берутся в начале обхода и живут до его конца
+    napi_value objectProto_{};
+    napi_value box_[boxCount]{};
+
+    void boxes(Napi::Env env)
+    {
+        auto global = env.Global();
+        objectProto_ = global.Get("Object").As<Napi::Object>().Get("prototype");
+        const char* names[boxCount] = {"Number", "String", "Boolean", "BigInt"};
+        for (std::size_t n = 0; n < boxCount; ++n)
+            box_[n] = global.Get(names[n]);
+    }
+
+    // значение внутри обертки или сам val
+    Napi::Value unbox(Napi::Value val) const
+    {
+        auto env = val.Env();
+        napi_value proto;
+        auto status = napi_get_prototype(env, val, &proto);
+        NAPI_THROW_IF_FAILED(env, status, val);
+        // обычный объект, дальше не проверяем
+        if (Napi::Value{env, proto}.StrictEquals(Napi::Value{env, objectProto_}))
+            return val;
+
+        auto obj = val.As<Napi::Object>();
+        auto box = [&](Box n) {
+            return obj.InstanceOf(Napi::Value{env, box_[n]}.As<Napi::Function>());
+        };
+        // ToNumber и ToString как в SerializeJSONProperty
+        if (box(boxNumber))
+            return val.ToNumber();
+        if (box(boxString))
+            return val.ToString();
+        for (auto n : {boxBoolean, boxBigInt})
+        {
+            if (box(n))
+            {
+                auto valueOf = Napi::Value{env, box_[n]}.As<Napi::Object>()
+                    .Get("prototype").As<Napi::Object>().Get("valueOf");
+                return valueOf.As<Napi::Function>().Call(val, {});
+            }
+        }
+        return val;
+    }
+
+    bool fail(std::string message)
+    {
+        error_ = std::move(message);
+        return false;
+    }
+
+    static bool skip(const Napi::Value& value)
+    {
+        return value.IsUndefined() || value.IsFunction() || value.IsSymbol();
+    }
+
+    // toJSON вызывается до проверки skip и получает ключ или индекс
+    // строка ключа создается только если toJSON есть
+    template<class K>
+    static Napi::Value toJSON(Napi::Value val, K key)
+    {
+        if (!val.IsObject() && !val.IsBigInt())
+            return val;
+        auto obj = val.ToObject();
+        auto f = obj.Get("toJSON");
+        if (!f.IsFunction())
+            return val;
+        return f.As<Napi::Function>().Call(val, {key()});
+    }
+
+    template<class H>
+    bool bigint(H& handler, const Napi::Value& value)
+    {
+        auto b = value.As<Napi::BigInt>();
+        bool lossless;
+        auto i = b.Int64Value(&lossless);
+        if (lossless)
+        {
+            return (i < 0) ? handler.Int64(i) : 
+                handler.Uint64(static_cast<std::uint64_t>(i));
+        }
+        auto u = b.Uint64Value(&lossless);
+        if (lossless)
+            return handler.Uint64(u);
+        return fail("BigInt value can't be represented as int64 or uint64");
+    }
+
+    // целые как у rapidjson::Reader, иначе схема не увидит integer
+    template<class H>
+    static bool number(H& handler, double d)
+    {
+        if (!std::isfinite(d))
+            return handler.Null();
+
+        if (d == std::trunc(d))
+        {
+            if ((d >= 0) && (d < 18446744073709551616.0)) {
+                auto u = static_cast<std::uint64_t>(d);
+                return (u <= std::numeric_limits<unsigned>::max()) ?
+                    handler.Uint(static_cast<unsigned>(u)) : handler.Uint64(u);
+            } else if ((d < 0) && (d >= -9223372036854775808.0)) {
+                auto i = static_cast<std::int64_t>(d);
+                return (i >= std::numeric_limits<int>::min()) ?
+                    handler.Int(static_cast<int>(i)) : handler.Int64(i);
+            }
+        }
+
+        return handler.Double(d);
+    }
+
+    template<class H>
+    bool array(H& handler, const Napi::Array& arr, std::size_t depth)
+    {
+        if (!handler.StartArray())
+            return false;
+        auto env = arr.Env();
+        auto length = arr.Length();
+        for (std::uint32_t i = 0; i < length; ++i)
+        {
+            // хэндлы элемента не копятся до конца обхода
+            Napi::HandleScope scope{env};
+            auto elem = toJSON(arr.Get(i), [&] {
+                return Napi::String::New(env, std::to_string(i));
+            });
+            if (skip(elem)) {
+                if (!handler.Null())
+                    return false;
+            } else if (!value(handler, elem, depth + 1)) {
+                return false;
+            }
+        }
+        return handler.EndArray(length);
+    }
+
+    template<class H>
+    bool object(H& handler, const Napi::Object& obj, std::size_t depth)
+    {
+        auto env = obj.Env();
+        // собственные перечисляемые ключи как у JSON.stringify
+        napi_value result;
+        auto status = napi_get_all_property_names(env, obj, 
+            napi_key_own_only, static_cast<napi_key_filter>(
+                napi_key_enumerable | napi_key_skip_symbols),
+            napi_key_numbers_to_strings, &result);
+        NAPI_THROW_IF_FAILED(env, status, false);
+
+        if (!handler.StartObject())
+            return false;
+
+        auto keys = Napi::Array(env, result);
+        auto length = keys.Length();
+        rapidjson::SizeType count = 0;
+        for (std::uint32_t i = 0; i < length; ++i)
+        {
+            Napi::HandleScope scope{env};
+            auto key = keys.Get(i);
+            auto elem = toJSON(obj.Get(key), [&] {
+                return key;
+            });
+            if (skip(elem))
+                continue;
+            auto name = key.As<Napi::String>().Utf8Value();
+            if (!handler.Key(name.data(), 
+                static_cast<rapidjson::SizeType>(name.size()), true))
+                return false;
+            if (!value(handler, elem, depth + 1))
+                return false;
+            ++count;
+        }
+        return handler.EndObject(count);
+    }
+
+    template<class H>
+    bool value(H& handler, Napi::Value val, std::size_t depth)
+    {
+        if (depth > value_max_depth)
+            return fail("value is nested too deeply");
+
+        if (val.IsNull() || skip(val))
+            return handler.Null();
+        if (val.IsBoolean())
+            return handler.Bool(val.As<Napi::Boolean>().Value());
+        if (val.IsNumber())
+            return number(handler, val.As<Napi::Number>().DoubleValue());
+        if (val.IsBigInt())
+            return bigint(handler, val);
+        if (val.IsString())
+        {
+            auto s = val.As<Napi::String>().Utf8Value();
+            return handler.String(s.data(), 
+                static_cast<rapidjson::SizeType>(s.size()), true);
+        }
+
+        // toJSON уже применен вызывающим
+        if (!val.IsArray())
+        {
+            val = unbox(val);
+            if (!val.IsObject())
+                return value(handler, val, depth);
+        }
+
+        auto obj = val.As<Napi::Object>();
+        for (auto& parent : stack_)
+        {
+            if (obj.StrictEquals(Napi::Value{obj.Env(), parent}))
+                return fail("Converting circular structure");
+        }
+
+        stack_.push_back(obj);
+        auto result = val.IsArray() ? 
+            array(handler, val.As<Napi::Array>(), depth) : 
+            object(handler, obj, depth);
+        stack_.pop_back();
+        return result;
+    }
+
+public:
+    explicit ValueReader(Napi::Value value)
+        : value_{value}
+    {   }
+
+    template<class H>
+    bool operator()(H& handler)
+    {
+        error_.clear();
+        stack_.clear();
+        auto env = value_.Env();
+        boxes(env);
+        auto val = toJSON(value_, [&] {
+            return Napi::String::New(env, "");
+        });
+        return value(handler, val, 0);
+    }
+
+    // ошибка обхода, не связанная с обработчиком
+    const std::string& error() const noexcept
+    {
+        return error_;
+    }
+};
+
+} // namespace rapid
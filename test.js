@@ -84,6 +84,22 @@ if (!schema.validate(document)) {
     console.log(`check: ${schema.validateKeyword()} (${schema.documentPointer()})`);
 }
 
+if (!schema.validateValue({ numbers: [1, 2, 3, 4, BigInt(9223372036854775801n)] })) {
+    console.log(`check: ${schema.validateKeyword()} (${schema.documentPointer()})`);
+} else {
+    console.log("schema validateValue ok");
+}
+
+if (!schema.validateValue({ numbers: [1, 2, 3] })) {
+    console.log(`check: ${schema.validateKeyword()} (${schema.documentPointer()})`);
+}
+
+// toJSON получает ключ, undefined удаляет член как в JSON.stringify
+const hidden = { toJSON: (key) => (key === "extra" ? undefined : 1) };
+console.log("toJSON", schema.validateValue({ numbers: [1, 2, 3, 4, 5], extra: hidden }));
+// обертки разворачиваются в примитивы
+console.log("boxed", schema.validateValue({ numbers: [new Number(1), 2, 3, 4, 5] }));
+
 // DEMO3
 
 const makeRapidPointer = RapidJSON.makeRapidPointer;
@@ -124,6 +140,76 @@ const pointer3 = makeRapidPointer(p3);
 console.log(p3, JSON.stringify(pointer3));
 console.log(JSONR.parse(example7, pointer3));
 
+// DEMO4
+
+const TapeView = RapidJSON.TapeView;
+if (!document.parse(Buffer.from(example5))) {
+    throw new Error(`document: ${document.parseMessage()} offset:${document.parseOffset()}`);
+}
+// ArrayBuffer можно передать в worker_threads через transferList
+const tape = new TapeView(document.toTape());
+console.log(tape.get("#/someArray/1", pointer));
+console.log(tape.get("/iWillBigInt", pointer), tape.get("/iWillNumber", pointer));
+
+const shared = new Uint8Array(new SharedArrayBuffer(document.tapeSize()));
+document.toTape(shared);
+console.log(new TapeView(shared).get("", pointer));
+
+// DEMO5
+
+const msgpack = document.toMsgPack();
+const cbor = document.toCbor();
+console.log(msgpack.length, cbor.length, example5.length);
+console.log(RapidDocument.fromMsgPack(msgpack).getResult(pointer));
+
+// DEMO6
+
+const fs = require("fs");
+const os = require("os");
+const path = require("path");
+const exampleFile = path.join(os.tmpdir(), "node-rapidjson-example.json");
+fs.writeFileSync(exampleFile, example5);
+if (!document.parseFile(exampleFile)) {
+    throw new Error(`document: ${document.parseMessage()} offset:${document.parseOffset()}`);
+}
+console.log(document.getResult(pointer));
+document.parseFile(exampleFile, { async: true }).then((ok) => {
+    if (!ok) {
+        throw new Error(`document: ${document.parseMessage()} offset:${document.parseOffset()}`);
+    }
+    console.log("async", document.getResult(pointer));
+    fs.unlinkSync(exampleFile);
+});
+
+// DEMO7
+
+for (const item of RapidJSON.iterateArray(example6, pointer2)) {
+    console.log("item", item);
+}
+
+try {
+    for (const item of RapidJSON.iterateArray("[1, 2] 3")) {
+        console.log("item", item);
+    }
+} catch (e) {
+    console.log(e.message);
+}
+
+const { Readable } = require("stream");
+(async () => {
+    const stream = Readable.from([Buffer.from("[{\"id\": 9223372036854775801}, {\"id\""), Buffer.from(": 42}]")]);
+    for await (const item of RapidJSON.iterateArray(stream, makeRapidPointer(["#/*/id"]))) {
+        console.log("stream item", item);
+    }
+})();
+
+// DEMO8
+
+for (const numbers of ["bigint-if-unsafe", "all-int64-bigint", "decimal-string"]) {
+    const parser = new RapidParser(0, { numbers });
+    console.log(numbers, parser.parse('[1, 9007199254740993, -9007199254740993, 18446744073709551616, 0.1, 3.141592653589793238]'));
+}
+
 // const RapidJSON = require("@ikonopistsev/node-rapidjson");
 // const RapidParser = RapidJSON.RapidParser;
 // const makeRapidPointer = RapidJSON.makeRapidPointer;